@@ -0,0 +1,128 @@
+#include "TLE75008_Bank.h"
+
+TLE75008_Bank::TLE75008_Bank(TLE75008_ESD* const* devices, uint8_t count) {
+
+  _devices = devices;
+  _count = count;
+  _urgent = false;
+  _image = NULL;
+  _front = 0;
+
+}
+
+void TLE75008_Bank::begin() {
+  for (uint8_t i = 0; i < _count; i++) _devices[i]->begin();
+}
+
+void TLE75008_Bank::flush() {
+  for (uint8_t i = 0; i < _count; i++) {
+    if (_urgent) serviceOff();  // Emergency requests preempt the rest of the flush
+    if (_devices[i]->probeStatus() == TLE75008_ABSENT) continue;
+    _devices[i]->flush();
+  }
+}
+
+void TLE75008_Bank::recallScene(const byte* masks) {
+  for (uint8_t i = 0; i < _count; i++) _devices[i]->setOutputs(masks[i]);
+  flush();
+}
+
+void TLE75008_Bank::recallScene_P(const byte* masks) {
+  for (uint8_t i = 0; i < _count; i++) _devices[i]->setOutputs(pgm_read_byte(masks + i));
+  flush();
+}
+
+void TLE75008_Bank::saveScene(byte* masks) const {
+  for (uint8_t i = 0; i < _count; i++) masks[i] = _devices[i]->getOutputs();
+}
+
+void TLE75008_Bank::attachImage(uint16_t* frames) {
+  _image = frames;
+  _front = 0;
+  for (uint8_t i = 0; i < _count; i++) {
+    _image[i] = _image[_count + i] = TLE75008_ESD::outFrame(_devices[i]->getOutputs());
+  }
+}
+
+void TLE75008_Bank::commit() {
+  if (!_image) return;
+
+  uint8_t back = _front ^ 1;
+  uint16_t* frames = _image + back * _count;
+  for (uint8_t i = 0; i < _count; i++) frames[i] = TLE75008_ESD::outFrame(_devices[i]->getOutputs());
+  _front = back;  // Single byte store, a stream in progress keeps its own copy of the index
+}
+
+void TLE75008_Bank::streamImage() {
+  if (!_image) return;
+
+  const uint16_t* frames = _image + _front * _count;
+  for (uint8_t i = 0; i < _count; i++) {
+    if (_urgent) serviceOff();
+    if (_devices[i]->probeStatus() == TLE75008_ABSENT) continue;
+    // Channels switched off in the shadow since the commit (on-time guard, emergency
+    // off, application) stay off; only turning channels on waits for a commit
+    _devices[i]->sendFrame(frames[i] & (0xFF00 | _devices[i]->getOutputs()));
+  }
+}
+
+void TLE75008_Bank::requestOff(TLE75008_Channel channel) {
+  _devices[channel.device]->requestOff(channel.mask);
+  _urgent = true;
+}
+
+void TLE75008_Bank::serviceOff() {
+  serviceOff(0, _count);
+}
+
+void TLE75008_Bank::serviceOff(uint8_t first, uint8_t end) {
+  _urgent = false;
+  for (uint8_t i = first; i < end; i++) _devices[i]->serviceOff();
+}
+
+void TLE75008_Bank::scanLoads(byte* map) {
+  // Devices in the scan have their outputs off and serve their own requests when
+  // they restore them, so only the others are written here
+  for (uint8_t i = 0; i < _count; i++) {
+    if (_urgent) serviceOff(i, _count);
+    if (_devices[i]->probeStatus() != TLE75008_ABSENT) _devices[i]->startLoadScan();
+  }
+  delayMicroseconds(TLE75008_LOAD_SCAN_SETTLE_US);
+  for (uint8_t i = 0; i < _count; i++) {
+    if (_urgent) serviceOff(0, i);
+    byte loads = 0;
+    if (_devices[i]->probeStatus() != TLE75008_ABSENT) loads = _devices[i]->finishLoadScan();
+    if (map) map[i] = loads;
+  }
+  if (_urgent) serviceOff();
+}
+
+#if TLE75008_ENABLE_DIAG_CACHE
+uint8_t TLE75008_Bank::updateDiagnostics() {
+  uint8_t changed = 0;
+  for (uint8_t i = 0; i < _count; i++) {
+    if (_urgent) serviceOff();
+    if (_devices[i]->probeStatus() == TLE75008_ABSENT || !_devices[i]->loadMask()) continue;
+    if (_devices[i]->updateDiagnostics()) changed++;
+  }
+  return changed;
+}
+#endif
+
+uint8_t TLE75008_Bank::verify() {
+  uint8_t repaired = 0;
+  for (uint8_t i = 0; i < _count; i++) {
+    if (_urgent) serviceOff();
+    if (_devices[i]->probeStatus() == TLE75008_ABSENT) continue;
+    if (!_devices[i]->verifyOutputs()) repaired++;
+  }
+  return repaired;
+}
+
+uint8_t TLE75008_Bank::probe() {
+  uint8_t present = 0;
+  for (uint8_t i = 0; i < _count; i++) {
+    if (_devices[i]->probe() == TLE75008_PRESENT) present++;
+  }
+  return present;
+}
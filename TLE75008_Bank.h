@@ -0,0 +1,78 @@
+#ifndef TLE75008_BANK_H
+#define TLE75008_BANK_H
+
+#include <Arduino.h>
+#include "TLE75008_ESD.h"
+
+// A named output: device index in the bank plus channel mask on that device
+struct TLE75008_Channel {
+    uint8_t device;
+    uint8_t mask;
+};
+
+// Build channel map entries at compile time, e.g.
+//   constexpr TLE75008_Channel PUMP_MAIN = TLE75008_Output(0, 3);
+//   constexpr TLE75008_Channel LAMPS[] = { TLE75008_Output(0, 4), TLE75008_Output(1, 1) };
+constexpr TLE75008_Channel TLE75008_Output(uint8_t device, uint8_t channel) {
+    return TLE75008_Channel{ device, (uint8_t)(1 << (channel - 1)) };
+}
+constexpr TLE75008_Channel TLE75008_Outputs(uint8_t device, uint8_t mask) {
+    return TLE75008_Channel{ device, mask };
+}
+
+// Several TLE75008 chips (each with its own CS pin) driven as one bank
+class TLE75008_Bank {
+public:
+    TLE75008_Bank(TLE75008_ESD* const* devices, uint8_t count);
+    void begin();
+    uint8_t count() const { return _count; }
+    TLE75008_ESD& device(uint8_t index) { return *_devices[index]; }
+
+    // Named channels and groups only change the shadows; flush() sends them
+    void set(TLE75008_Channel channel, bool state) { _devices[channel.device]->setGroup(channel.mask, state); }
+    bool get(TLE75008_Channel channel) const { return (_devices[channel.device]->getOutputs() & channel.mask) != 0; }
+    template <size_t N>
+    void set(const TLE75008_Channel (&group)[N], bool state) {
+        for (size_t i = 0; i < N; i++) set(group[i], state);
+    }
+    void flush();  // One frame per changed device, nothing for unchanged or absent ones
+
+    // Scenes: one OUT mask per device. Only devices whose outputs differ are written
+    void recallScene(const byte* masks);
+    void recallScene_P(const byte* masks);  // Scene stored in PROGMEM
+    void saveScene(byte* masks) const;      // Current outputs into a RAM scene
+
+    // Double-buffered frame image: set() edits the shadows (back), commit() turns them into
+    // precomputed frames and swaps them to the front, streamImage() only sends the front
+    // (masked with the shadows, so channels switched off since the commit stay off)
+    void attachImage(uint16_t* frames);  // Room for 2 * count() frames
+    void commit();
+    void streamImage();
+
+    // Emergency off: safe to call from an ISR. A running flush() handles it at the
+    // next frame boundary; otherwise call serviceOff() from loop()
+    void requestOff(TLE75008_Channel channel);
+    void serviceOff();
+
+    // Commissioning: scan all devices for attached loads with one settle delay for the whole bank
+    void scanLoads(byte* map = NULL);  // Optionally copies each device's load mask into map
+#if TLE75008_ENABLE_DIAG_CACHE
+    uint8_t updateDiagnostics();  // Skips absent devices and devices without loads; returns devices changed
+#endif
+
+    // Recovery: verifyOutputs() on every present device; returns devices that had to be rewritten
+    uint8_t verify();
+
+    // Probe every device; absent ones are skipped by flush() from then on
+    uint8_t probe();  // Returns number of devices present
+
+private:
+    TLE75008_ESD* const* _devices;
+    uint8_t _count;
+    volatile bool _urgent;
+    uint16_t* _image;
+    volatile uint8_t _front;  // Which half of _image is streamed
+    void serviceOff(uint8_t first, uint8_t end);  // Devices first..end-1 only
+};
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef TLE75008_CONFIG_H
+#define TLE75008_CONFIG_H
+
+// Feature selection. Everything is on by default; define TLE75008_PROFILE_LEAN for
+// the bare driver (outputs, per-channel diagnostics, probe, emergency off) or set
+// single features to 0 or 1 here or with compiler flags. Disabled features cost no
+// RAM and no flash.
+#ifdef TLE75008_PROFILE_LEAN
+#define TLE75008_FEATURE_DEFAULT 0
+#else
+#define TLE75008_FEATURE_DEFAULT 1
+#endif
+
+// Diagnostic snapshot masks (updateDiagnostics(), group diagnostics). Needed by
+// TLE75008_Logger and TLE75008_Redundant
+#ifndef TLE75008_ENABLE_DIAG_CACHE
+#define TLE75008_ENABLE_DIAG_CACHE TLE75008_FEATURE_DEFAULT
+#endif
+
+// Frame counter and fault scores (fault scores also need the diagnostic cache)
+#ifndef TLE75008_ENABLE_STATS
+#define TLE75008_ENABLE_STATS TLE75008_FEATURE_DEFAULT
+#endif
+
+// TLE75008_Trace and the trace hooks in the driver
+#ifndef TLE75008_ENABLE_TRACE
+#define TLE75008_ENABLE_TRACE TLE75008_FEATURE_DEFAULT
+#endif
+
+// Maximum on-time guard, the only timed work scheduled inside the driver (48 bytes per chip)
+#ifndef TLE75008_ENABLE_ONTIME_GUARD
+#define TLE75008_ENABLE_ONTIME_GUARD TLE75008_FEATURE_DEFAULT
+#endif
+
+// Fault injection hook for recovery testing. Off in every profile, turn on explicitly
+#ifndef TLE75008_ENABLE_FAULT_INJECTION
+#define TLE75008_ENABLE_FAULT_INJECTION 0
+#endif
+
+// Zero-cross synchronized switching (one interrupt pin shared by all chips)
+#ifndef TLE75008_ENABLE_ZERO_CROSS
+#define TLE75008_ENABLE_ZERO_CROSS TLE75008_FEATURE_DEFAULT
+#endif
+
+#endif
@@ -10,14 +10,62 @@
 #define HWCR_REGISTER 0x0C
 #define HWCR_OCL_REGISTER 0x0D
 
+// Probe signature, written to MAPIN0 and read back
+#define PROBE_PATTERN_A 0xA5
+#define PROBE_PATTERN_B 0x5A
+#define MAPIN0_DEFAULT  0x04
+
 // TLE75008-ESD Commands
 #define READ_COMMAND  0x01
 #define WRITE_COMMAND 0x80
 
+#if TLE75008_ENABLE_ZERO_CROSS
+TLE75008_ESD* TLE75008_ESD::_zc_first = NULL;
+volatile bool TLE75008_ESD::_bus_busy = false;
+volatile bool TLE75008_ESD::_zc_deferred = false;
+volatile uint32_t TLE75008_ESD::_zc_edge_us = 0;
+volatile uint16_t TLE75008_ESD::_zc_latency_max = 0;
+#endif
+
+#if TLE75008_ENABLE_FAULT_INJECTION
+TLE75008_FaultHook TLE75008_ESD::_fault_hook = NULL;
+#endif
+
 TLE75008_ESD::TLE75008_ESD(uint8_t cs_pin, uint8_t idle_pin) {
 
   _cs_pin = cs_pin;
   _idle_pin = idle_pin;
+  _out = 0;
+  _sent = 0;
+  _probe = TLE75008_PRESENT;
+  _kill = 0;
+#if TLE75008_ENABLE_DIAG_CACHE
+  _overload = 0;
+  _open_load = 0;
+  _status_monitor = 0;
+  _load_mask = 0xFF;
+#endif
+#if TLE75008_ENABLE_STATS
+  _frames = 0;
+#endif
+#if TLE75008_ENABLE_STATS && TLE75008_ENABLE_DIAG_CACHE
+  _scoring = 0;
+  memset(_fault_score, 0, sizeof(_fault_score));
+#endif
+#if TLE75008_ENABLE_TRACE
+  _trace = NULL;
+#endif
+#if TLE75008_ENABLE_ZERO_CROSS
+  _zc_mask = 0;
+  _zc_sent = 0;
+  _zc_pending = false;
+  _zc_frame = 0;
+  _zc_next = NULL;
+#endif
+#if TLE75008_ENABLE_ONTIME_GUARD
+  _guard_mask = 0;
+  _guard_next = 0;
+#endif
 
 }
 
@@ -30,10 +78,14 @@ void TLE75008_ESD::begin() {
   digitalWrite(_idle_pin, LOW);  // Enter Limp Home mode initially
 
   SPI.begin();
-  SPI.beginTransaction(SPISettings(5000000, MSBFIRST, SPI_MODE1));
+  SPI.beginTransaction(SPISettings(TLE75008_SPI_CLOCK, MSBFIRST, SPI_MODE1));
 
   // Initialize the TLE75008-ESD chip
   initialize();
+
+  // The settings stay in the SPI hardware; an open transaction would keep interrupts
+  // registered with SPI.usingInterrupt() (the zero-cross one) masked
+  SPI.endTransaction();
 }
 
 void TLE75008_ESD::initialize() {
@@ -45,7 +97,7 @@ void TLE75008_ESD::initialize() {
   writeRegister(HWCR_OCL_REGISTER, 0xFF);
   
   // Configure input mapping registers
-  writeRegister(MAPIN0_REGISTER, 0x04);  // Map IN0 to channel 2 (default)
+  writeRegister(MAPIN0_REGISTER, MAPIN0_DEFAULT);  // Map IN0 to channel 2 (default)
   writeRegister(MAPIN1_REGISTER, 0x08);  // Map IN1 to channel 3 (default)
   
   // Enable open load diagnostic current
@@ -56,21 +108,228 @@ void TLE75008_ESD::initialize() {
 
   // Configure necessary registers to enable diagnostics
   writeRegister(DIAG_OSM_REGISTER, 0xFF); // Enable output status monitoring
+
+  // Seed the output shadow from the chip
+  _out = readRegister(OUT_REGISTER);
+  _sent = _out;
+#if TLE75008_ENABLE_ZERO_CROSS
+  _zc_sent = _out;
+#endif
+}
+
+bool TLE75008_ESD::verifyOutputs() {
+#if TLE75008_ENABLE_ZERO_CROSS
+  // The chip should hold what was last sent; a frame staged for the zero cross stays staged.
+  // One frame sequence, so the ISR can't send that frame between the read and the rewrite
+  bool nested = _bus_busy;
+  _bus_busy = true;
+  bool ok = readRegister(OUT_REGISTER) == _zc_sent;
+  if (!ok) writeRegister(OUT_REGISTER, _zc_sent);
+  if (!nested) endFrame();
+  return ok;
+#else
+  // Unflushed shadow changes are not a fault, flush() sends them
+  if (readRegister(OUT_REGISTER) == _sent) return true;
+  writeRegister(OUT_REGISTER, _sent);
+  return false;
+#endif
+}
+
+byte TLE75008_ESD::probe() {
+  writeRegister(MAPIN0_REGISTER, PROBE_PATTERN_A);
+  byte a = readRegister(MAPIN0_REGISTER);
+  writeRegister(MAPIN0_REGISTER, PROBE_PATTERN_B);
+  byte b = readRegister(MAPIN0_REGISTER);
+  writeRegister(MAPIN0_REGISTER, MAPIN0_DEFAULT);
+
+  if (a == PROBE_PATTERN_A && b == PROBE_PATTERN_B) {
+    _probe = TLE75008_PRESENT;
+  } else if (a == 0xFF && b == 0xFF) {
+    _probe = TLE75008_ABSENT;
+  } else {
+    _probe = TLE75008_STUCK;
+  }
+  return _probe;
 }
 
 void TLE75008_ESD::toggleOutput(byte channel, bool state) {
+  setOutput(channel, state);
+  flush();
+}
+
+void TLE75008_ESD::setOutput(byte channel, bool state) {
 
   channel = channel - 1;
 
   if (channel > 7) return;  // Channel out of range
 
-  byte currentOutputState = readRegister(OUT_REGISTER);
+  byte newOutputState = _out;
   if (state) {
-    currentOutputState |= (1 << channel);  // Set bit to 1
+    newOutputState |= (1 << channel);  // Set bit to 1
+  } else {
+    newOutputState &= ~(1 << channel); // Set bit to 0
+  }
+  setOutputs(newOutputState);
+}
+
+void TLE75008_ESD::setOutputs(byte mask) {
+  if (mask == _out) return;
+
+#if TLE75008_ENABLE_ONTIME_GUARD
+  // Start the on-time clock for guarded channels that turn on
+  byte rising = mask & ~_out & _guard_mask;
+#endif
+  _out = mask;
+#if TLE75008_ENABLE_ONTIME_GUARD
+  if (rising) {
+    uint32_t now = millis();
+    for (byte i = 0; i < 8; i++) {
+      if (rising & (1 << i)) _guard_deadline[i] = now + _guard_limit[i];
+    }
+    updateGuardNext();
+  }
+#endif
+}
+
+void TLE75008_ESD::setGroup(byte mask, bool state) {
+  setOutputs(state ? (_out | mask) : (_out & ~mask));
+}
+
+void TLE75008_ESD::toggleGroup(byte mask, bool state) {
+  setGroup(mask, state);
+  flush();
+}
+
+byte TLE75008_ESD::serviceOff() {
+  if (!_kill) return 0;
+
+  noInterrupts();
+  byte kill = _kill;
+  _kill = 0;
+  interrupts();
+
+  // Pending normal changes go out in the same frame
+  setOutputs(_out & ~kill);
+#if TLE75008_ENABLE_ZERO_CROSS
+  // Never wait for a zero cross to switch off; held channels waiting to switch on stay staged
+  sendFrame(outFrame(_out));
+#else
+  flush();
+#endif
+  return kill;
+}
+
+void TLE75008_ESD::flush() {
+  if (_kill) {
+    serviceOff();
+    return;
+  }
+  if (_out == _sent) return;
+#if TLE75008_ENABLE_ZERO_CROSS
+  if ((_out ^ _zc_sent) & _zc_mask) {
+    // A held channel changed: stage the whole frame for the next zero cross
+    noInterrupts();
+    _zc_frame = outFrame(_out);
+    _zc_pending = true;
+    interrupts();
+    _sent = _out;
+    return;
+  }
+  _zc_pending = false;  // Held channels are back where the chip has them, drop any staged frame
+  _zc_sent = _out;
+#endif
+#if TLE75008_ENABLE_TRACE
+  uint32_t start = micros();
+#endif
+  writeRegister(OUT_REGISTER, _out);
+  _sent = _out;
+#if TLE75008_ENABLE_TRACE
+  if (_trace) _trace->record(TLE75008_TRACE_FLUSH, _cs_pin, OUT_REGISTER, _out, start);
+#endif
+}
+
+#if TLE75008_ENABLE_ONTIME_GUARD
+void TLE75008_ESD::setMaxOnTime(byte channel, uint16_t ms) {
+
+  channel = channel - 1;
+
+  if (channel > 7) return;  // Channel out of range
+
+  _guard_limit[channel] = ms;
+  if (ms) {
+    _guard_mask |= (1 << channel);
+    _guard_deadline[channel] = millis() + ms;  // Already on: count from now
   } else {
-    currentOutputState &= ~(1 << channel); // Set bit to 0
+    _guard_mask &= ~(1 << channel);
+  }
+  updateGuardNext();
+}
+
+byte TLE75008_ESD::checkOnTime() {
+  byte armed = _out & _guard_mask;
+  if (!armed) return 0;
+
+  // Common case: nothing due yet
+  uint32_t now = millis();
+  if ((int32_t)(now - _guard_next) < 0) return 0;
+
+  byte expired = 0;
+  for (byte i = 0; i < 8; i++) {
+    if ((armed & (1 << i)) && (int32_t)(now - _guard_deadline[i]) >= 0) expired |= (1 << i);
   }
-  writeRegister(OUT_REGISTER, currentOutputState);
+  if (expired) {
+    setOutputs(_out & ~expired);
+    flush();  // All expired channels off in one frame
+  }
+  updateGuardNext();
+  return expired;
+}
+
+void TLE75008_ESD::updateGuardNext() {
+  byte armed = _out & _guard_mask;
+  bool found = false;
+  for (byte i = 0; i < 8; i++) {
+    if (!(armed & (1 << i))) continue;
+    if (!found || (int32_t)(_guard_deadline[i] - _guard_next) < 0) _guard_next = _guard_deadline[i];
+    found = true;
+  }
+}
+#endif
+
+byte TLE75008_ESD::scanLoads() {
+  startLoadScan();
+  delayMicroseconds(TLE75008_LOAD_SCAN_SETTLE_US);
+  return finishLoadScan();
+}
+
+void TLE75008_ESD::startLoadScan() {
+  // Open load is detected with the output off and the diagnostic current on (set by initialize())
+#if TLE75008_ENABLE_ZERO_CROSS
+  noInterrupts();
+  _zc_pending = false;  // A zero cross during the settle time must not switch outputs back on
+  _zc_sent = 0;
+  interrupts();
+#endif
+  writeRegister(OUT_REGISTER, 0x00);
+}
+
+byte TLE75008_ESD::finishLoadScan() {
+  byte openLoad = readRegister(DIAG_OSM_REGISTER);
+
+  // Restore the outputs from the shadow (held zero-cross channels at the zero cross); an
+  // emergency off requested during the scan goes out with the same frame
+  noInterrupts();
+  byte kill = _kill;
+  _kill = 0;
+  interrupts();
+  setOutputs(_out & ~kill);
+  sendFrame(outFrame(_out));
+
+  byte loads = ~openLoad;
+#if TLE75008_ENABLE_DIAG_CACHE
+  _load_mask = loads;
+#endif
+  return loads;
 }
 
 // Diagnostic Functions
@@ -98,17 +357,210 @@ bool TLE75008_ESD::getOutputStatusMonitor(byte channel) {
     return (status & (1 << channel)) != 0;
 }
 
+#if TLE75008_ENABLE_DIAG_CACHE
+byte TLE75008_ESD::updateDiagnostics() {
+  byte overload = readRegister(INST_REGISTER) & _load_mask;
+  byte openLoad = readRegister(DIAG_OSM_REGISTER) & _load_mask;
+  byte statusMonitor = readRegister(DIAG_IOL_REGISTER);
+
+  byte changed = (overload ^ _overload) | (openLoad ^ _open_load) | (statusMonitor ^ _status_monitor);
+#if TLE75008_ENABLE_STATS
+  updateFaultScores((overload & ~_overload) | (openLoad & ~_open_load));
+#endif
+  _overload = overload;
+  _open_load = openLoad;
+  _status_monitor = statusMonitor;
+#if TLE75008_ENABLE_TRACE
+  if (_trace && changed) _trace->record(TLE75008_TRACE_FAULT, _cs_pin, INST_REGISTER, changed, micros());
+#endif
+  return changed;
+}
+#endif
+
+#if TLE75008_ENABLE_STATS && TLE75008_ENABLE_DIAG_CACHE
+void TLE75008_ESD::updateFaultScores(byte new_faults) {
+  // Only channels with a score or a new fault need any work
+  byte active = _scoring | new_faults;
+  if (!active) return;
+
+  for (byte i = 0; i < 8; i++) {
+    if (!(active & (1 << i))) continue;
+    uint16_t score = _fault_score[i];
+    if (score) score -= (score >> TLE75008_FAULT_DECAY_SHIFT) | 1;  // | 1 so it always reaches zero
+    if (new_faults & (1 << i)) {
+      score = (score > 0xFFFF - TLE75008_FAULT_WEIGHT) ? 0xFFFF : score + TLE75008_FAULT_WEIGHT;
+    }
+    _fault_score[i] = score;
+    if (score) {
+      _scoring |= (1 << i);
+    } else {
+      _scoring &= ~(1 << i);
+    }
+  }
+}
+
+uint16_t TLE75008_ESD::getFaultScore(byte channel) const {
+
+  channel = channel - 1;
+
+  if (channel > 7) return 0;  // Channel out of range
+  return _fault_score[channel];
+}
+
+byte TLE75008_ESD::trendingMask(uint16_t threshold) const {
+  byte mask = 0;
+  for (byte i = 0; i < 8; i++) {
+    if ((_scoring & (1 << i)) && _fault_score[i] >= threshold) mask |= (1 << i);
+  }
+  return mask;
+}
+#endif
+
+// Predicted bus time for a number of frames: shift time plus CS overhead per frame.
+// Shift time is worked out over all frames so fractional microseconds don't add up
+uint32_t TLE75008_ESD::busTimeMicros(uint32_t frames, uint32_t spi_clock) {
+  uint32_t shift_us = (uint64_t)frames * TLE75008_FRAME_BITS * 1000000UL / spi_clock;
+  return shift_us + frames * TLE75008_CS_OVERHEAD_US;
+}
+
+#if TLE75008_ENABLE_ZERO_CROSS
+void TLE75008_ESD::beginZeroCross(uint8_t pin, int edge) {
+  pinMode(pin, INPUT);
+  SPI.usingInterrupt(digitalPinToInterrupt(pin));  // Other libraries' SPI transactions hold it off
+  attachInterrupt(digitalPinToInterrupt(pin), zeroCrossISR, edge);
+}
+
+void TLE75008_ESD::holdForZeroCross(byte mask) {
+  if (mask) {
+    // Join the list served by the interrupt, once
+    noInterrupts();
+    TLE75008_ESD* dev = _zc_first;
+    while (dev && dev != this) dev = dev->_zc_next;
+    if (!dev) {
+      _zc_next = _zc_first;
+      _zc_first = this;
+    }
+    interrupts();
+  }
+  _zc_mask = mask;  // A chip with no held channels stays listed, it just never stages frames
+}
+
+void TLE75008_ESD::zeroCrossISR() {
+  _zc_edge_us = micros();
+  if (_bus_busy) {
+    _zc_deferred = true;  // Main code is inside a frame, it sends ours when done
+    return;
+  }
+  sendZeroCrossFrames();
+}
+
+void TLE75008_ESD::sendZeroCrossFrames() {
+  for (TLE75008_ESD* dev = _zc_first; dev; dev = dev->_zc_next) {
+    if (!dev->_zc_pending) continue;
+    dev->_zc_pending = false;
+    dev->_zc_sent = dev->_zc_frame & 0xFF;
+    dev->writeFrame(dev->_zc_frame);
+  }
+  uint16_t latency = micros() - _zc_edge_us;
+  if (latency > _zc_latency_max) _zc_latency_max = latency;
+}
+
+// Called by main code after every frame
+void TLE75008_ESD::endFrame() {
+  _bus_busy = false;
+  if (!_zc_deferred) return;
+  noInterrupts();
+  _zc_deferred = false;
+  sendZeroCrossFrames();
+  interrupts();
+}
+#endif
+
+uint16_t TLE75008_ESD::outFrame(byte mask) {
+  return ((uint16_t)(WRITE_COMMAND | OUT_REGISTER) << 8) | mask;
+}
+
+void TLE75008_ESD::sendFrame(uint16_t frame) {
+  if ((frame >> 8) != (WRITE_COMMAND | OUT_REGISTER)) {
+    writeFrame(frame);
+    return;
+  }
+  _sent = frame & 0xFF;
+#if TLE75008_ENABLE_ZERO_CROSS
+  // Held channels switch off now but only on at the zero cross: send them as the chip
+  // has them and stage the full frame
+  byte rising = _sent & ~_zc_sent & _zc_mask;
+  noInterrupts();
+  _zc_pending = false;  // This frame replaces any staged one
+  interrupts();
+  frame &= ~(uint16_t)rising;
+  _zc_sent = frame & 0xFF;
+  writeFrame(frame);
+  if (rising) {
+    noInterrupts();
+    _zc_frame = outFrame(_sent);
+    _zc_pending = true;
+    interrupts();
+  }
+#else
+  writeFrame(frame);
+#endif
+}
+
 void TLE75008_ESD::writeRegister(byte reg, byte value) {
-  digitalWrite(_cs_pin, LOW);
-  SPI.transfer(WRITE_COMMAND | reg);
-  SPI.transfer(value);
-  digitalWrite(_cs_pin, HIGH);
+  writeFrame(((uint16_t)(WRITE_COMMAND | reg) << 8) | value);
+}
+
+void TLE75008_ESD::writeFrame(uint16_t frame) {
+#if TLE75008_ENABLE_TRACE
+  uint32_t start = _trace ? micros() : 0;
+#endif
+#if TLE75008_ENABLE_STATS
+  _frames++;
+#endif
+#if TLE75008_ENABLE_ZERO_CROSS
+  bool nested = _bus_busy;  // Already inside a frame sequence or the zero-cross ISR
+  _bus_busy = true;
+#endif
+  transfer(frame);
+#if TLE75008_ENABLE_TRACE
+  if (_trace) _trace->record(TLE75008_TRACE_WRITE, _cs_pin, (frame >> 8) & ~WRITE_COMMAND, frame & 0xFF, start);
+#endif
+#if TLE75008_ENABLE_ZERO_CROSS
+  if (!nested) endFrame();
+#endif
 }
 
 byte TLE75008_ESD::readRegister(byte reg) {
+#if TLE75008_ENABLE_TRACE
+  uint32_t start = _trace ? micros() : 0;
+#endif
+#if TLE75008_ENABLE_STATS
+  _frames++;
+#endif
+#if TLE75008_ENABLE_ZERO_CROSS
+  bool nested = _bus_busy;  // Already inside a frame sequence or the zero-cross ISR
+  _bus_busy = true;
+#endif
+  byte result = transfer((uint16_t)(READ_COMMAND | reg) << 8) & 0xFF;
+#if TLE75008_ENABLE_TRACE
+  if (_trace) _trace->record(TLE75008_TRACE_READ, _cs_pin, reg, result, start);
+#endif
+#if TLE75008_ENABLE_ZERO_CROSS
+  if (!nested) endFrame();
+#endif
+  return result;
+}
+
+uint16_t TLE75008_ESD::transfer(uint16_t frame) {
+#if TLE75008_ENABLE_FAULT_INJECTION
+  if (_fault_hook && !_fault_hook(_cs_pin, &frame, false)) return 0xFFFF;  // Lost frame, MISO idles high
+#endif
   digitalWrite(_cs_pin, LOW);
-  SPI.transfer(READ_COMMAND | reg);
-  byte result = SPI.transfer(0x00);
+  uint16_t response = SPI.transfer16(frame);  // Whole frame in one transfer
   digitalWrite(_cs_pin, HIGH);
-  return result;
+#if TLE75008_ENABLE_FAULT_INJECTION
+  if (_fault_hook) _fault_hook(_cs_pin, &response, true);
+#endif
+  return response;
 }
\ No newline at end of file
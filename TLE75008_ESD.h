@@ -3,6 +3,39 @@
 
 #include <Arduino.h>
 #include <SPI.h>
+#include "TLE75008_Config.h"
+#include "TLE75008_Trace.h"
+
+// Channel number (1-8) to channel mask bit
+#define TLE75008_CH(channel) ((byte)(1 << ((channel) - 1)))
+
+// Probe results
+#define TLE75008_PRESENT 0
+#define TLE75008_ABSENT  1  // Nothing answers (MISO idles high)
+#define TLE75008_STUCK   2  // Something answers, but not with the written pattern
+
+// Fault score: each new fault adds 1.0 (256 in 8.8 fixed point), every diagnostic
+// snapshot decays a score by 1/2^TLE75008_FAULT_DECAY_SHIFT
+#ifndef TLE75008_FAULT_DECAY_SHIFT
+#define TLE75008_FAULT_DECAY_SHIFT 4
+#endif
+#define TLE75008_FAULT_WEIGHT 256
+
+// Time for open-load detection to settle after outputs are switched off
+#ifndef TLE75008_LOAD_SCAN_SETTLE_US
+#define TLE75008_LOAD_SCAN_SETTLE_US 500
+#endif
+
+// SPI bus settings used for every frame
+#define TLE75008_SPI_CLOCK 5000000
+#define TLE75008_FRAME_BITS 16
+#define TLE75008_CS_OVERHEAD_US 4  // CS toggling + call overhead per frame (estimate, AVR @16MHz)
+
+#if TLE75008_ENABLE_FAULT_INJECTION
+// Sees every frame before it is sent (response = false) and every reply after it is
+// received (response = true) and may change it. Return false on a frame to drop it
+typedef bool (*TLE75008_FaultHook)(uint8_t cs_pin, uint16_t* frame, bool response);
+#endif
 
 class TLE75008_ESD {
 public:
@@ -10,16 +43,143 @@ public:
     void begin();
     void toggleOutput(byte channel, bool state);  // Method to set output ON or OFF
 
+    // Recovery: read OUT back and rewrite it if it differs from the shadow
+    bool verifyOutputs();  // True if the chip was already correct
+
+#if TLE75008_ENABLE_FAULT_INJECTION
+    static void setFaultHook(TLE75008_FaultHook hook) { _fault_hook = hook; }
+#endif
+
+    // Presence check: writes and reads back a signature, then restores the register
+    byte probe();
+    byte probeStatus() const { return _probe; }  // TLE75008_PRESENT until probe() says otherwise
+
+    // Buffered outputs: change the shadow register, then flush() once
+    void setOutput(byte channel, bool state);
+    void setOutputs(byte mask);
+    byte getOutputs() const { return _out; }
+    void flush();  // Writes OUT only if the shadow changed
+
+#if TLE75008_ENABLE_ZERO_CROSS
+    // Zero-cross switching: changes to held channels are sent from the zero-cross interrupt
+    static void beginZeroCross(uint8_t pin, int edge = RISING);
+    void holdForZeroCross(byte mask);
+    static uint16_t zeroCrossLatency() { return _zc_latency_max; }  // Worst edge to last frame, us
+#endif
+
+    // Precomputed frames, e.g. for TLE75008_Bank frame images
+    static uint16_t outFrame(byte mask);  // OUT register write frame
+    void sendFrame(uint16_t frame);  // Held zero-cross channels still switch on at the zero cross
+
+    // Emergency off: safe to call from an ISR, sent ahead of normal changes
+    void requestOff(byte mask) { _kill |= mask; }
+    byte serviceOff();  // Applies pending requests in one frame; returns the channels switched off
+
+    // Paralleled channels: every channel in the mask switches in the same OUT frame
+    void setGroup(byte mask, bool state);
+    void toggleGroup(byte mask, bool state);  // setGroup() + flush()
+#if TLE75008_ENABLE_DIAG_CACHE
+    bool groupOverload(byte mask) const { return (_overload & mask) != 0; }  // From the last updateDiagnostics()
+    bool groupOpenLoad(byte mask) const { return (_open_load & mask) != 0; }
+#endif
+
+#if TLE75008_ENABLE_ONTIME_GUARD
+    // Maximum on-time guard: channels left on longer than the limit are switched off
+    void setMaxOnTime(byte channel, uint16_t ms);  // 0 disables the guard
+    byte checkOnTime();  // Call from loop(); returns mask of channels switched off
+#endif
+
+    // Commissioning: find which channels have a load attached. Outputs are off during the scan
+    byte scanLoads();       // startLoadScan(), settle, finishLoadScan()
+    void startLoadScan();
+    byte finishLoadScan();  // Returns mask of channels with a load, restores outputs and config
+
     // Diagnostic Functions
     bool getOverloadStatus(byte channel);
     bool getOpenLoadStatus(byte channel);
     bool getOutputStatusMonitor(byte channel);
 
+#if TLE75008_ENABLE_DIAG_CACHE
+    // Diagnostic snapshot: read all diagnostic registers once, then query the masks
+    byte updateDiagnostics();  // Returns mask of channels whose flags changed
+    byte overloadMask() const { return _overload; }
+    byte openLoadMask() const { return _open_load; }
+    byte statusMonitorMask() const { return _status_monitor; }
+    byte loadMask() const { return _load_mask; }  // From the last load scan, 0xFF before
+    void setLoadMask(byte mask) { _load_mask = mask; }  // Faults on other channels are ignored
+#endif
+
+#if TLE75008_ENABLE_STATS && TLE75008_ENABLE_DIAG_CACHE
+    // Fault rate per channel, updated by updateDiagnostics()
+    uint16_t getFaultScore(byte channel) const;
+    byte trendingMask(uint16_t threshold) const;  // Channels with a score at or above threshold
+#endif
+
+    // Bus timing / planning
+#if TLE75008_ENABLE_STATS
+    uint32_t frameCount() const { return _frames; }  // Frames sent since begin()
+    void resetFrameCount() { _frames = 0; }
+#endif
+    static uint32_t busTimeMicros(uint32_t frames, uint32_t spi_clock = TLE75008_SPI_CLOCK);
+
+#if TLE75008_ENABLE_TRACE
+    // Tracing: record frames, flushes and fault edges into a trace buffer (NULL to stop)
+    void attachTrace(TLE75008_Trace* trace) { _trace = trace; }
+#endif
+
 private:
     uint8_t _cs_pin;
     uint8_t _idle_pin;
+    byte _out;
+    byte _sent;  // Last OUT value sent (or staged); flush() has work when it differs from _out
+    byte _probe;
+    volatile byte _kill;
+#if TLE75008_ENABLE_DIAG_CACHE
+    byte _overload;
+    byte _open_load;
+    byte _status_monitor;
+    byte _load_mask;
+#endif
+#if TLE75008_ENABLE_STATS
+    uint32_t _frames;
+#endif
+#if TLE75008_ENABLE_STATS && TLE75008_ENABLE_DIAG_CACHE
+    uint16_t _fault_score[8];
+    byte _scoring;  // Channels with a non-zero score
+    void updateFaultScores(byte new_faults);
+#endif
+#if TLE75008_ENABLE_TRACE
+    TLE75008_Trace* _trace;
+#endif
+#if TLE75008_ENABLE_ZERO_CROSS
+    byte _zc_mask;
+    byte _zc_sent;            // Last OUT value on the chip
+    volatile bool _zc_pending;
+    uint16_t _zc_frame;       // Precomputed frame waiting for the zero cross
+    TLE75008_ESD* _zc_next;
+    static TLE75008_ESD* _zc_first;
+    static volatile bool _bus_busy;
+    static volatile bool _zc_deferred;  // Edge arrived during a frame, send right after it
+    static volatile uint32_t _zc_edge_us;
+    static volatile uint16_t _zc_latency_max;
+    static void zeroCrossISR();
+    static void sendZeroCrossFrames();
+    void endFrame();
+#endif
+#if TLE75008_ENABLE_ONTIME_GUARD
+    byte _guard_mask;
+    uint16_t _guard_limit[8];
+    uint32_t _guard_deadline[8];
+    uint32_t _guard_next;  // Earliest deadline of all guarded channels that are on
+    void updateGuardNext();
+#endif
     void initialize();
     void writeRegister(byte reg, byte value);
+    void writeFrame(uint16_t frame);
+    uint16_t transfer(uint16_t frame);
+#if TLE75008_ENABLE_FAULT_INJECTION
+    static TLE75008_FaultHook _fault_hook;
+#endif
     byte readRegister(byte reg);
 };
 
@@ -0,0 +1,32 @@
+#include "TLE75008_Latching.h"
+
+TLE75008_Latching::TLE75008_Latching(TLE75008_Bank& bank, TLE75008_Channel set_coil, TLE75008_Channel reset_coil, uint16_t pulse_ms)
+  : _bank(bank) {
+
+  _set_coil = set_coil;
+  _reset_coil = reset_coil;
+  _pulse_ms = pulse_ms;
+  _pulse_start = 0;
+  _state = false;
+  _pulsing = false;
+
+}
+
+void TLE75008_Latching::set(bool state, bool force) {
+  if (state == _state && !force) return;
+
+  // Never drive both coils: the other one is off in the same frame
+  _bank.set(state ? _reset_coil : _set_coil, false);
+  _bank.set(state ? _set_coil : _reset_coil, true);
+  _state = state;
+  _pulsing = true;
+  _pulse_start = millis();
+}
+
+void TLE75008_Latching::update() {
+  if (!_pulsing || millis() - _pulse_start < _pulse_ms) return;
+
+  _bank.set(_set_coil, false);
+  _bank.set(_reset_coil, false);
+  _pulsing = false;
+}
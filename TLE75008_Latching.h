@@ -0,0 +1,28 @@
+#ifndef TLE75008_LATCHING_H
+#define TLE75008_LATCHING_H
+
+#include <Arduino.h>
+#include "TLE75008_Bank.h"
+
+// Bistable relay with a set coil and a reset coil on two bank channels. Pulses are
+// timed without blocking; call update() for all relays, then one bank.flush()
+class TLE75008_Latching {
+public:
+    TLE75008_Latching(TLE75008_Bank& bank, TLE75008_Channel set_coil, TLE75008_Channel reset_coil, uint16_t pulse_ms = 20);
+    void set(bool state, bool force = false);  // Pulses only on a change unless forced (e.g. at startup)
+    bool get() const { return _state; }        // Commanded state, no SPI read
+    bool busy() const { return _pulsing; }
+    void setPulseWidth(uint16_t ms) { _pulse_ms = ms; }
+    void update();  // Ends the pulse when it is due
+
+private:
+    TLE75008_Bank& _bank;
+    TLE75008_Channel _set_coil;
+    TLE75008_Channel _reset_coil;
+    uint16_t _pulse_ms;
+    uint32_t _pulse_start;
+    bool _state;
+    bool _pulsing;
+};
+
+#endif
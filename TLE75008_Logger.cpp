@@ -0,0 +1,54 @@
+#include "TLE75008_Logger.h"
+
+#if TLE75008_ENABLE_DIAG_CACHE
+
+TLE75008_Logger::TLE75008_Logger(TLE75008_BlockWriter writer) {
+
+  _writer = writer;
+  _active = 0;
+  _fill = 0;
+  _full = false;
+  _dropped = 0;
+
+}
+
+bool TLE75008_Logger::log(uint8_t device, const TLE75008_ESD& chip) {
+  if (_fill + sizeof(TLE75008_LogRecord) > TLE75008_LOG_BLOCK) {
+    if (_full) {  // Writer is behind, both blocks are full
+      _dropped++;
+      return false;
+    }
+    memset(_blocks[_active] + _fill, 0xFF, TLE75008_LOG_BLOCK - _fill);  // Pad unused tail
+    _full = true;
+    _active ^= 1;
+    _fill = 0;
+  }
+
+  TLE75008_LogRecord record;
+  record.time_ms = millis();
+  record.device = device;
+  record.outputs = chip.getOutputs();
+  record.overload = chip.overloadMask();
+  record.open_load = chip.openLoadMask();
+  memcpy(_blocks[_active] + _fill, &record, sizeof(record));
+  _fill += sizeof(record);
+  return true;
+}
+
+void TLE75008_Logger::logBank(TLE75008_Bank& bank) {
+  for (uint8_t i = 0; i < bank.count(); i++) log(i, bank.device(i));
+}
+
+void TLE75008_Logger::update() {
+  if (!_full) return;
+  if (_writer(_blocks[_active ^ 1], TLE75008_LOG_BLOCK)) _full = false;
+}
+
+void TLE75008_Logger::flush() {
+  update();
+  if (_full || _fill == 0) return;
+  memset(_blocks[_active] + _fill, 0xFF, TLE75008_LOG_BLOCK - _fill);
+  if (_writer(_blocks[_active], TLE75008_LOG_BLOCK)) _fill = 0;
+}
+
+#endif
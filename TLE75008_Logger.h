@@ -0,0 +1,47 @@
+#ifndef TLE75008_LOGGER_H
+#define TLE75008_LOGGER_H
+
+#include <Arduino.h>
+#include "TLE75008_ESD.h"
+#include "TLE75008_Bank.h"
+
+#if TLE75008_ENABLE_DIAG_CACHE
+// Block size handed to the writer (512 = one SD card sector)
+#ifndef TLE75008_LOG_BLOCK
+#define TLE75008_LOG_BLOCK 512
+#endif
+
+// One log record, 8 bytes, little endian on all supported boards
+struct TLE75008_LogRecord {
+    uint32_t time_ms;
+    uint8_t device;
+    uint8_t outputs;
+    uint8_t overload;
+    uint8_t open_load;
+};
+
+// Writes one full block; return false to retry on the next update()
+typedef bool (*TLE75008_BlockWriter)(const uint8_t* block, uint16_t size);
+
+// Double-buffered logger: records go into one block while the other waits for the writer
+class TLE75008_Logger {
+public:
+    TLE75008_Logger(TLE75008_BlockWriter writer);
+    bool log(uint8_t device, const TLE75008_ESD& chip);  // False if the record was dropped
+    void logBank(TLE75008_Bank& bank);
+    void update();  // Call from loop(): hands a full block to the writer
+    void flush();   // Pads and writes the partial block now (e.g. before power off)
+    uint32_t dropped() const { return _dropped; }
+
+private:
+    TLE75008_BlockWriter _writer;
+    uint8_t _blocks[2][TLE75008_LOG_BLOCK];
+    uint8_t _active;
+    uint16_t _fill;
+    volatile bool _full;  // The inactive block is waiting for the writer
+    uint32_t _dropped;
+};
+
+#endif
+
+#endif
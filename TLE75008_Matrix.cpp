@@ -0,0 +1,80 @@
+#include "TLE75008_Matrix.h"
+
+TLE75008_Matrix::TLE75008_Matrix(TLE75008_ESD& chip, const byte* row_channels, uint8_t rows, uint16_t slot_us)
+  : _chip(chip) {
+
+  _columns = NULL;
+  _rows = rows > TLE75008_MATRIX_MAX_ROWS ? TLE75008_MATRIX_MAX_ROWS : rows;
+  _all_rows = 0;
+  for (uint8_t i = 0; i < _rows; i++) {
+    _row_bit[i] = TLE75008_CH(row_channels[i]);
+    _all_rows |= _row_bit[i];
+    _on_us[i] = slot_us;  // Full brightness
+  }
+  _slot_us = slot_us;
+  _row = 0;
+  _lit = false;
+  _slot_start = 0;
+  _window_start = 0;
+  _window_scans = 0;
+  _window_frames = 0;
+  _refresh = 0;
+  _load = 0;
+  _base = 0;
+  buildFrames();
+
+}
+
+void TLE75008_Matrix::setBrightness(uint8_t row, uint8_t level) {
+  if (row >= _rows) return;
+  _on_us[row] = (uint32_t)_slot_us * level / 255;
+}
+
+void TLE75008_Matrix::buildFrames() {
+  _base = _chip.getOutputs() & ~_all_rows;
+  _blank_frame = TLE75008_ESD::outFrame(_base);
+  for (uint8_t i = 0; i < _rows; i++) _frames[i] = TLE75008_ESD::outFrame(_base | _row_bit[i]);
+}
+
+// Sends a precomputed frame and keeps the chip's shadow in step with it
+void TLE75008_Matrix::send(uint16_t frame) {
+  _chip.setOutputs(frame & 0xFF);
+  _chip.sendFrame(frame);
+  _window_frames++;
+}
+
+void TLE75008_Matrix::update() {
+  if (!_rows) return;
+  uint32_t now = micros();
+  uint32_t elapsed = now - _slot_start;
+  if ((_chip.getOutputs() & ~_all_rows) != _base) buildFrames();  // Other channels changed, before any frame reverts them
+
+  if (_lit && elapsed >= _on_us[_row]) {
+    send(_blank_frame);
+    _lit = false;
+  }
+
+  if (elapsed >= _slot_us) {
+    _row++;
+    if (_row >= _rows) {
+      _row = 0;
+      _window_scans++;
+    }
+    if (_columns) _columns(_row);
+
+    _slot_start = now;
+    if (_on_us[_row]) {
+      send(_frames[_row]);
+      _lit = true;
+    }
+  }
+
+  uint32_t window = now - _window_start;
+  if (window >= 1000000UL) {
+    _refresh = (uint32_t)_window_scans * 1000000UL / window;
+    _load = TLE75008_ESD::busTimeMicros(_window_frames) * 100UL / window;
+    _window_scans = 0;
+    _window_frames = 0;
+    _window_start = now;
+  }
+}
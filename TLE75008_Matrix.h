@@ -0,0 +1,47 @@
+#ifndef TLE75008_MATRIX_H
+#define TLE75008_MATRIX_H
+
+#include <Arduino.h>
+#include "TLE75008_ESD.h"
+
+#define TLE75008_MATRIX_MAX_ROWS 8
+
+// Multiplexed lamp/LED matrix with row drivers on channels of one chip. Each row gets a
+// fixed time slot and is lit for part of it (brightness). Frames are precomputed per row,
+// so update() only sends them; call it from loop() as often as possible. Not from an interrupt:
+// it updates the chip's output shadow and uses the bus like any other main code
+class TLE75008_Matrix {
+public:
+    TLE75008_Matrix(TLE75008_ESD& chip, const byte* row_channels, uint8_t rows, uint16_t slot_us = 1000);
+    void onRow(void (*columns)(uint8_t row)) { _columns = columns; }  // Set column drivers for the next row
+    void setBrightness(uint8_t row, uint8_t level);  // 0-255, share of the slot the row is lit
+    void update();
+
+    // Measured over the last second
+    uint16_t refreshRate() const { return _refresh; }  // Full matrix scans per second
+    uint8_t busLoad() const { return _load; }          // Percent of bus time used by the matrix
+
+private:
+    TLE75008_ESD& _chip;
+    void (*_columns)(uint8_t row);
+    byte _row_bit[TLE75008_MATRIX_MAX_ROWS];
+    byte _all_rows;
+    byte _base;  // Other channels on the chip, as the frames were built with
+    uint16_t _frames[TLE75008_MATRIX_MAX_ROWS];
+    uint16_t _blank_frame;
+    uint16_t _on_us[TLE75008_MATRIX_MAX_ROWS];
+    uint16_t _slot_us;
+    uint8_t _rows;
+    uint8_t _row;
+    bool _lit;
+    uint32_t _slot_start;
+    uint32_t _window_start;
+    uint16_t _window_scans;
+    uint32_t _window_frames;
+    uint16_t _refresh;
+    uint8_t _load;
+    void buildFrames();
+    void send(uint16_t frame);
+};
+
+#endif
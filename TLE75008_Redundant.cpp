@@ -0,0 +1,37 @@
+#include "TLE75008_Redundant.h"
+
+#if TLE75008_ENABLE_DIAG_CACHE
+
+TLE75008_Redundant::TLE75008_Redundant(TLE75008_Bank& bank, TLE75008_Channel primary, TLE75008_Channel backup)
+  : _bank(bank) {
+
+  _primary = primary;
+  _backup = backup;
+  _state = false;
+  _failed = false;
+
+}
+
+void TLE75008_Redundant::set(bool state) {
+  _state = state;
+  _bank.set(_failed ? _backup : _primary, state);
+  _bank.set(_failed ? _primary : _backup, false);
+}
+
+bool TLE75008_Redundant::update() {
+  if (_failed) return false;
+
+  TLE75008_ESD& chip = _bank.device(_primary.device);
+  if (!chip.groupOverload(_primary.mask) && !chip.groupOpenLoad(_primary.mask)) return false;
+
+  _failed = true;
+  set(_state);
+  return true;
+}
+
+void TLE75008_Redundant::reset() {
+  _failed = false;
+  set(_state);
+}
+
+#endif
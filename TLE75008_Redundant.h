@@ -0,0 +1,31 @@
+#ifndef TLE75008_REDUNDANT_H
+#define TLE75008_REDUNDANT_H
+
+#include <Arduino.h>
+#include "TLE75008_Bank.h"
+
+#if TLE75008_ENABLE_DIAG_CACHE
+// One logical output wired through a primary and a backup channel, usually on different chips
+class TLE75008_Redundant {
+public:
+    TLE75008_Redundant(TLE75008_Bank& bank, TLE75008_Channel primary, TLE75008_Channel backup);
+    void set(bool state);  // Drives the active channel, keeps the other off
+    bool get() const { return _state; }
+
+    // Call after updateDiagnostics() on the chips; on a fault of the active primary the
+    // backup takes over in the shadows, so the next bank flush() switches both together
+    bool update();  // True if it failed over
+    bool failedOver() const { return _failed; }
+    void reset();   // Back to the primary, e.g. after repair
+
+private:
+    TLE75008_Bank& _bank;
+    TLE75008_Channel _primary;
+    TLE75008_Channel _backup;
+    bool _state;
+    bool _failed;
+};
+
+#endif
+
+#endif
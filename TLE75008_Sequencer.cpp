@@ -0,0 +1,123 @@
+#include "TLE75008_Sequencer.h"
+
+TLE75008_Sequencer::TLE75008_Sequencer(TLE75008_Bank& bank)
+  : _bank(bank) {
+
+  _length = 0;
+  for (uint8_t i = 0; i < TLE75008_SEQ_SLOTS; i++) _slots[i].running = false;
+
+}
+
+bool TLE75008_Sequencer::load(Stream& in) {
+  uint8_t length;
+  if (in.readBytes(&length, 1) != 1 || length > TLE75008_SEQ_SIZE) return false;
+
+  for (uint8_t i = 0; i < TLE75008_SEQ_SLOTS; i++) stop(i);  // Running code is about to change
+  if (in.readBytes(_program, length) != length) {
+    _length = 0;
+    return false;
+  }
+  _length = length;
+  return true;
+}
+
+bool TLE75008_Sequencer::load(const uint8_t* program, uint8_t length) {
+  if (length > TLE75008_SEQ_SIZE) return false;
+
+  for (uint8_t i = 0; i < TLE75008_SEQ_SLOTS; i++) stop(i);
+  memcpy(_program, program, length);
+  _length = length;
+  return true;
+}
+
+bool TLE75008_Sequencer::start(uint8_t slot, uint8_t address) {
+  if (slot >= TLE75008_SEQ_SLOTS || address >= _length) return false;
+
+  _slots[slot].running = true;
+  _slots[slot].pc = address;
+  _slots[slot].depth = 0;
+  _slots[slot].wait = 0;
+  return true;
+}
+
+void TLE75008_Sequencer::stop(uint8_t slot) {
+  if (slot < TLE75008_SEQ_SLOTS) _slots[slot].running = false;
+}
+
+void TLE75008_Sequencer::tick() {
+  for (uint8_t i = 0; i < TLE75008_SEQ_SLOTS; i++) {
+    if (_slots[i].running) step(_slots[i]);
+  }
+  _bank.flush();  // Everything from this tick in one pass
+}
+
+// Runs one sequence until it waits, ends or uses up its steps for this tick
+void TLE75008_Sequencer::step(Slot& slot) {
+  if (slot.wait) {
+    slot.wait--;
+    return;
+  }
+
+  for (uint8_t steps = 0; steps < TLE75008_SEQ_MAX_STEPS; steps++) {
+    uint8_t pc = slot.pc;
+    uint8_t op = pc < _length ? _program[pc] : TLE75008_OP_END;
+    uint8_t arg0 = pc + 1 < _length ? _program[pc + 1] : 0;
+    uint8_t arg1 = pc + 2 < _length ? _program[pc + 2] : 0;
+
+    if (op != TLE75008_OP_END && pc + 2 >= _length) op = TLE75008_OP_END;  // Truncated instruction
+
+    switch (op) {
+      case TLE75008_OP_SET:
+      case TLE75008_OP_CLEAR:
+        if (arg0 < _bank.count()) _bank.set(TLE75008_Outputs(arg0, arg1), op == TLE75008_OP_SET);
+        slot.pc += 3;
+        break;
+
+      case TLE75008_OP_WAIT:
+        slot.pc += 3;
+        slot.wait = arg0 | ((uint16_t)arg1 << 8);
+        if (slot.wait) {
+          slot.wait--;  // This tick counts
+          return;
+        }
+        break;
+
+#if TLE75008_ENABLE_DIAG_CACHE
+      case TLE75008_OP_WAIT_FAULT:
+        if (arg0 < _bank.count()) {
+          TLE75008_ESD& chip = _bank.device(arg0);
+          if (!chip.groupOverload(arg1) && !chip.groupOpenLoad(arg1)) return;  // Check again next tick
+        }
+        slot.pc += 3;
+        break;
+#endif
+
+      case TLE75008_OP_LOOP:
+        if (arg1 == 0) {  // Forever
+          slot.pc = arg0;
+          break;
+        }
+        if (slot.depth == 0 || slot.loop[slot.depth - 1].pc != pc) {  // Entering the loop
+          if (slot.depth == TLE75008_SEQ_LOOP_DEPTH) {  // Nested too deep
+            slot.running = false;
+            return;
+          }
+          slot.loop[slot.depth].pc = pc;
+          slot.loop[slot.depth].remaining = arg1;
+          slot.depth++;
+        }
+        if (slot.loop[slot.depth - 1].remaining) {
+          slot.loop[slot.depth - 1].remaining--;
+          slot.pc = arg0;
+        } else {
+          slot.depth--;  // Done, the enclosing loop is on top again
+          slot.pc += 3;
+        }
+        break;
+
+      default:
+        slot.running = false;
+        return;
+    }
+  }
+}
@@ -0,0 +1,61 @@
+#ifndef TLE75008_SEQUENCER_H
+#define TLE75008_SEQUENCER_H
+
+#include <Arduino.h>
+#include "TLE75008_Bank.h"
+
+// Program buffer size in bytes and number of sequences that can run at once
+#ifndef TLE75008_SEQ_SIZE
+#define TLE75008_SEQ_SIZE 128
+#endif
+#ifndef TLE75008_SEQ_SLOTS
+#define TLE75008_SEQ_SLOTS 4
+#endif
+#ifndef TLE75008_SEQ_LOOP_DEPTH
+#define TLE75008_SEQ_LOOP_DEPTH 3  // Counted LOOPs that can be nested in one sequence
+#endif
+#define TLE75008_SEQ_MAX_STEPS 16  // Instructions per sequence per tick, stops runaway loops
+
+// Bytecode, one opcode byte followed by its arguments
+#define TLE75008_OP_END        0x00  // Stop this sequence
+#define TLE75008_OP_SET        0x01  // device, mask: turn channels on
+#define TLE75008_OP_CLEAR      0x02  // device, mask: turn channels off
+#define TLE75008_OP_WAIT       0x03  // ticks (2 bytes, little endian)
+#define TLE75008_OP_WAIT_FAULT 0x04  // device, mask: wait until one of the channels faults
+#define TLE75008_OP_LOOP       0x05  // address, count: jump back count times (0 = forever)
+
+// Runs several bytecode output sequences on a bank, with one bank flush per tick
+class TLE75008_Sequencer {
+public:
+    TLE75008_Sequencer(TLE75008_Bank& bank);
+
+    // Program: length byte then that many bytes, e.g. over Serial. False on timeout or too long
+    bool load(Stream& in);
+    bool load(const uint8_t* program, uint8_t length);
+
+    bool start(uint8_t slot, uint8_t address);
+    void stop(uint8_t slot);
+    bool running(uint8_t slot) const { return slot < TLE75008_SEQ_SLOTS && _slots[slot].running; }
+
+    void tick();  // Call at a fixed rate; WAIT counts these ticks
+
+private:
+    struct Slot {
+        bool running;
+        uint8_t pc;
+        uint16_t wait;
+        struct {
+            uint8_t pc;         // Address of the LOOP instruction
+            uint8_t remaining;  // Jumps left
+        } loop[TLE75008_SEQ_LOOP_DEPTH];
+        uint8_t depth;  // Counted LOOPs currently open, innermost on top
+    };
+
+    TLE75008_Bank& _bank;
+    uint8_t _program[TLE75008_SEQ_SIZE];
+    uint8_t _length;
+    Slot _slots[TLE75008_SEQ_SLOTS];
+    void step(Slot& slot);
+};
+
+#endif
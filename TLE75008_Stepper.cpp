@@ -0,0 +1,92 @@
+#include "TLE75008_Stepper.h"
+
+TLE75008_Stepper::TLE75008_Stepper(TLE75008_Bank& bank, uint8_t device, byte ch_a, byte ch_b, byte ch_c, byte ch_d, bool half_step)
+  : _bank(bank) {
+
+  _device = device;
+  byte coil[4] = { TLE75008_CH(ch_a), TLE75008_CH(ch_b), TLE75008_CH(ch_c), TLE75008_CH(ch_d) };
+  _coils = coil[0] | coil[1] | coil[2] | coil[3];
+
+  // Full step drives two coils at a time (AB, BC, CD, DA); half step adds the single coils in between
+  if (half_step) {
+    _phase_count = 8;
+    for (uint8_t i = 0; i < 4; i++) {
+      _phases[2 * i] = coil[i];
+      _phases[2 * i + 1] = coil[i] | coil[(i + 1) & 3];
+    }
+  } else {
+    _phase_count = 4;
+    for (uint8_t i = 0; i < 4; i++) _phases[i] = coil[i] | coil[(i + 1) & 3];
+  }
+
+  _phase = 0;
+  _position = 0;
+  _target = 0;
+  _max_speed = 200;
+  _start_speed = 50;
+  _accel = 0;
+  _speed = 0;
+  _dir = 0;
+  _accel_frac = 0;
+  _interval = 0;
+  _last_step = 0;
+
+}
+
+void TLE75008_Stepper::release() {
+  _target = _position;
+  _speed = 0;
+  _dir = 0;
+  _bank.set(TLE75008_Outputs(_device, _coils), false);
+}
+
+bool TLE75008_Stepper::update() {
+  int8_t dir = _target > _position ? 1 : (_target < _position ? -1 : 0);
+
+  // A new target behind the motor while still above start speed: brake in the old
+  // direction first, the remaining steps come back after the reversal
+  bool braking = _speed && _accel && dir != 0 && _dir != 0 && dir != _dir && _speed > _start_speed;
+  if (!braking && dir == 0) {
+    _speed = 0;
+    _dir = 0;
+    return false;
+  }
+
+  uint32_t now = micros();
+  if (_speed && now - _last_step < _interval) return false;
+
+  if (braking) dir = _dir;
+  _dir = dir;
+  _phase = dir > 0 ? (_phase + 1) % _phase_count : (_phase + _phase_count - 1) % _phase_count;
+  TLE75008_ESD& chip = _bank.device(_device);
+  chip.setOutputs((chip.getOutputs() & ~_coils) | _phases[_phase]);
+  _position += dir;
+  _last_step = _speed ? _last_step + _interval : now;  // Keep the step grid, don't add loop jitter
+
+  uint32_t remaining = 0;  // Braking to reverse
+  if (!braking) remaining = dir > 0 ? (uint32_t)(_target - _position) : (uint32_t)(_position - _target);
+  nextSpeed(remaining);
+  return true;
+}
+
+// Linear ramp: speed changes by accel * interval = accel / speed each step, braking
+// once the remaining steps are what it takes to stop (v^2 / 2a)
+void TLE75008_Stepper::nextSpeed(uint32_t remaining) {
+  if (!_accel || _speed == 0) {
+    _speed = (_accel && _start_speed < _max_speed) ? _start_speed : _max_speed;
+    _accel_frac = 0;
+  } else {
+    _accel_frac += _accel;
+    uint32_t dv = _accel_frac / _speed;
+    _accel_frac %= _speed;
+
+    uint32_t stop_steps = (uint32_t)_speed * _speed / (2UL * _accel);
+    if (remaining <= stop_steps) {
+      _speed = (_speed > _start_speed + dv) ? _speed - dv : _start_speed;
+    } else if (_speed < _max_speed) {
+      _speed = ((uint32_t)(_max_speed - _speed) > dv) ? _speed + dv : _max_speed;
+    }
+  }
+  if (_speed == 0) _speed = 1;
+  _interval = 1000000UL / _speed;
+}
@@ -0,0 +1,46 @@
+#ifndef TLE75008_STEPPER_H
+#define TLE75008_STEPPER_H
+
+#include <Arduino.h>
+#include "TLE75008_Bank.h"
+
+// Unipolar stepper on four channels of one chip (coil order A, B, C, D). update() changes
+// only the output shadow; call it for every motor, then one bank.flush() so motors on
+// the same chip step in the same frame
+class TLE75008_Stepper {
+public:
+    TLE75008_Stepper(TLE75008_Bank& bank, uint8_t device, byte ch_a, byte ch_b, byte ch_c, byte ch_d, bool half_step = false);
+
+    void setMaxSpeed(uint16_t steps_per_s) { _max_speed = steps_per_s; }
+    void setStartSpeed(uint16_t steps_per_s) { _start_speed = steps_per_s; }
+    void setAcceleration(uint16_t steps_per_s2) { _accel = steps_per_s2; }  // 0 = no ramps
+
+    void moveTo(int32_t target) { _target = target; }
+    void move(int32_t steps) { _target = _position + steps; }
+    int32_t position() const { return _position; }
+    bool running() const { return _position != _target || _speed; }
+    void release();  // All coils off, no holding torque
+
+    bool update();  // Call from loop() or a timer tick; true if it stepped
+
+private:
+    TLE75008_Bank& _bank;
+    uint8_t _device;
+    byte _coils;      // All four channels
+    byte _phases[8];  // Channel mask for each step of the sequence
+    uint8_t _phase_count;
+    uint8_t _phase;
+    int32_t _position;
+    int32_t _target;
+    uint16_t _max_speed;
+    uint16_t _start_speed;
+    uint16_t _accel;
+    uint16_t _speed;  // Current speed, steps/s, 0 = standing
+    int8_t _dir;      // Direction of the last step, 0 = standing
+    uint32_t _accel_frac;  // Speed change carried over between steps, in 1/_speed steps/s
+    uint32_t _interval;    // us until the next step
+    uint32_t _last_step;
+    void nextSpeed(uint32_t remaining);
+};
+
+#endif
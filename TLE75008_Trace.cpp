@@ -0,0 +1,62 @@
+#include "TLE75008_Trace.h"
+
+#if TLE75008_ENABLE_TRACE
+
+TLE75008_Trace::TLE75008_Trace() {
+  clear();
+}
+
+void TLE75008_Trace::clear() {
+  _head = 0;
+  _count = 0;
+}
+
+void TLE75008_Trace::record(uint8_t type, uint8_t device, uint8_t reg, uint8_t value, uint32_t start_us) {
+  uint32_t now = micros();
+  TLE75008_TraceEvent& e = _events[_head];
+  e.time_us = start_us;
+  e.duration_us = (uint16_t)(now - start_us);
+  e.type = type;
+  e.device = device;
+  e.reg = reg;
+  e.value = value;
+
+  _head = (_head + 1) % TLE75008_TRACE_SIZE;
+  if (_count < TLE75008_TRACE_SIZE) _count++;
+}
+
+const TLE75008_TraceEvent& TLE75008_Trace::event(uint16_t index) const {
+  uint16_t oldest = (_head + TLE75008_TRACE_SIZE - _count) % TLE75008_TRACE_SIZE;
+  return _events[(oldest + index) % TLE75008_TRACE_SIZE];
+}
+
+void TLE75008_Trace::printChromeTrace(Print& out) const {
+  static const char* const names[] = { "write", "read", "flush", "fault" };
+
+  out.print("{\"traceEvents\":[");
+  for (uint16_t i = 0; i < _count; i++) {
+    const TLE75008_TraceEvent& e = event(i);
+    if (i) out.print(",");
+    out.print("{\"name\":\"");
+    out.print(names[e.type & 3]);
+    if (e.type == TLE75008_TRACE_FAULT) {
+      out.print("\",\"ph\":\"i\",\"s\":\"t\",");  // Instant event
+    } else {
+      out.print("\",\"ph\":\"X\",\"dur\":");
+      out.print((unsigned int)e.duration_us);
+      out.print(",");
+    }
+    out.print("\"ts\":");
+    out.print((unsigned long)e.time_us);
+    out.print(",\"pid\":0,\"tid\":");
+    out.print((unsigned int)e.device);
+    out.print(",\"args\":{\"reg\":");
+    out.print((unsigned int)e.reg);
+    out.print(",\"value\":");
+    out.print((unsigned int)e.value);
+    out.print("}}");
+  }
+  out.println("]}");
+}
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef TLE75008_TRACE_H
+#define TLE75008_TRACE_H
+
+#include <Arduino.h>
+#include "TLE75008_Config.h"
+
+#if TLE75008_ENABLE_TRACE
+// Number of events kept; oldest events are overwritten when full
+#ifndef TLE75008_TRACE_SIZE
+#define TLE75008_TRACE_SIZE 64
+#endif
+
+// Trace event types
+#define TLE75008_TRACE_WRITE 0
+#define TLE75008_TRACE_READ  1
+#define TLE75008_TRACE_FLUSH 2
+#define TLE75008_TRACE_FAULT 3
+
+struct TLE75008_TraceEvent {
+    uint32_t time_us;
+    uint16_t duration_us;
+    uint8_t type;
+    uint8_t device;  // CS pin of the chip
+    uint8_t reg;
+    uint8_t value;   // Register value, or changed channel mask for faults
+};
+
+class TLE75008_Trace {
+public:
+    TLE75008_Trace();
+    void clear();
+    void record(uint8_t type, uint8_t device, uint8_t reg, uint8_t value, uint32_t start_us);
+    uint16_t count() const { return _count; }
+    const TLE75008_TraceEvent& event(uint16_t index) const;  // 0 = oldest
+
+    // Print the buffer as Chrome trace JSON (load in chrome://tracing or ui.perfetto.dev)
+    void printChromeTrace(Print& out) const;
+
+private:
+    TLE75008_TraceEvent _events[TLE75008_TRACE_SIZE];
+    uint16_t _head;
+    uint16_t _count;
+};
+
+#endif
+
+#endif
@@ -0,0 +1,167 @@
+/*********************************************************************************************************************
+Benchmark Program For TLE75008
+
+Times single toggles, bank flushes and diagnostic scans on real hardware and prints frames per second and latency
+percentiles, plus CPU cycles per operation on AVR (Timer1) and on Cortex-M3/M4/M7 (DWT, e.g. SAMD51).
+*********************************************************************************************************************/
+
+#include <Arduino.h>
+#include <TLE75008_ESD.h>
+#include <TLE75008_Bank.h>
+#include <TLE75008_Matrix.h>
+
+#if !TLE75008_ENABLE_STATS || !TLE75008_ENABLE_DIAG_CACHE
+#error "The benchmark needs TLE75008_ENABLE_STATS and TLE75008_ENABLE_DIAG_CACHE"
+#endif
+
+// TLE75008 Chip Select & IDLE Pins
+#define IDLE 7
+#define CSA 10
+#define CSB 9
+
+#define SAMPLES 64
+
+TLE75008_ESD SWA(CSA, IDLE);
+TLE75008_ESD SWB(CSB, IDLE);
+TLE75008_ESD* const chips[] = { &SWA, &SWB };
+TLE75008_Bank bank(chips, 2);
+
+// 8 row matrix on the second chip, 500us per row
+const byte matrixRows[] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+TLE75008_Matrix matrix(SWB, matrixRows, 8, 500);
+
+uint32_t samples[SAMPLES];
+
+#if defined(DWT)
+#define HAVE_CYCLES
+void cycleCounterBegin() {
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+uint32_t cycles() { return DWT->CYCCNT; }
+#define CYCLES_SINCE(start) (cycles() - (start))
+#elif defined(__AVR__)
+#define HAVE_CYCLES
+void cycleCounterBegin() {
+  TCCR1A = 0;
+  TCCR1B = _BV(CS10);  // Timer1 counts CPU cycles, no prescaler
+}
+uint32_t cycles() { return TCNT1; }
+#define CYCLES_SINCE(start) ((uint16_t)(cycles() - (start)))  // 16 bit, ops are far below 65536 cycles
+#endif
+
+uint32_t framesSent() {
+  return SWA.frameCount() + SWB.frameCount();
+}
+
+void sortSamples() {
+  for (uint16_t i = 1; i < SAMPLES; i++) {
+    uint32_t v = samples[i];
+    int16_t j = i - 1;
+    while (j >= 0 && samples[j] > v) {
+      samples[j + 1] = samples[j];
+      j--;
+    }
+    samples[j + 1] = v;
+  }
+}
+
+// Runs one workload SAMPLES times and prints the results
+void report(const char* name, void (*workload)(uint16_t)) {
+  uint32_t frames = framesSent();
+  uint32_t total_us = 0;
+#ifdef HAVE_CYCLES
+  uint32_t total_cycles = 0;
+#endif
+
+  for (uint16_t i = 0; i < SAMPLES; i++) {
+#ifdef HAVE_CYCLES
+    uint32_t c = cycles();
+#endif
+    uint32_t t = micros();
+    workload(i);
+    samples[i] = micros() - t;
+#ifdef HAVE_CYCLES
+    total_cycles += CYCLES_SINCE(c);
+#endif
+    total_us += samples[i];
+  }
+  frames = framesSent() - frames;
+  sortSamples();
+
+  Serial.print(name);
+  Serial.print(": frames/op=");
+  Serial.print((float)frames / SAMPLES, 1);
+  Serial.print(" frames/s=");
+  Serial.print(total_us ? (uint32_t)((uint64_t)frames * 1000000UL / total_us) : 0);
+  Serial.print(" us p50=");
+  Serial.print(samples[SAMPLES / 2]);
+  Serial.print(" p90=");
+  Serial.print(samples[SAMPLES * 9 / 10]);
+  Serial.print(" max=");
+  Serial.print(samples[SAMPLES - 1]);
+#ifdef HAVE_CYCLES
+  Serial.print(" cycles/op=");
+  Serial.print(total_cycles / SAMPLES);
+#endif
+  Serial.println();
+}
+
+void singleToggle(uint16_t i) {
+  SWA.toggleOutput(1, i & 1);
+}
+
+void bankFlush(uint16_t i) {
+  SWA.setOutputs(i & 1 ? 0x55 : 0xAA);
+  SWB.setOutputs(i & 1 ? 0xAA : 0x55);
+  bank.flush();
+}
+
+void diagnosticScan(uint16_t i) {
+  (void)i;
+  SWA.updateDiagnostics();
+  SWB.updateDiagnostics();
+}
+
+// Scans the matrix for a bit over a second so its one second window is filled
+void reportMatrix() {
+  for (uint8_t row = 0; row < 8; row++) matrix.setBrightness(row, 32 * row + 31);
+  uint32_t start = millis();
+  while (millis() - start < 1100) matrix.update();
+
+  Serial.print("matrix      : refresh/s=");
+  Serial.print(matrix.refreshRate());
+  Serial.print(" bus load=");
+  Serial.print(matrix.busLoad());
+  Serial.println("%");
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) {}
+
+#ifdef HAVE_CYCLES
+  cycleCounterBegin();
+#endif
+
+  bank.begin();
+  Serial.print("Chips present: ");
+  Serial.println(bank.probe());
+  Serial.print("Model: us per frame=");
+  Serial.println(TLE75008_ESD::busTimeMicros(1));
+}
+
+void loop() {
+  report("toggleOutput", singleToggle);
+  report("bank flush  ", bankFlush);
+  report("diag scan   ", diagnosticScan);
+  reportMatrix();
+  Serial.println();
+
+  // Leave all outputs off between runs
+  SWA.setOutputs(0);
+  SWB.setOutputs(0);
+  bank.flush();
+  delay(2000);
+}
@@ -0,0 +1,94 @@
+/*********************************************************************************************************************
+Frame Efficiency Report For TLE75008
+
+Runs a synthetic workload of output changes and diagnostic reads on a bank, works out the minimum number of frames
+any driver would need for it and compares that with the frames this driver actually sent, per operation type.
+
+Minimum per tick: one OUT write for each chip whose outputs really changed, and one read per diagnostic register
+that is needed (all three for a full snapshot).
+*********************************************************************************************************************/
+
+#include <Arduino.h>
+#include <TLE75008_ESD.h>
+#include <TLE75008_Bank.h>
+
+#if !TLE75008_ENABLE_STATS || !TLE75008_ENABLE_DIAG_CACHE
+#error "The efficiency report needs TLE75008_ENABLE_STATS and TLE75008_ENABLE_DIAG_CACHE"
+#endif
+
+// TLE75008 Chip Select & IDLE Pins
+#define IDLE 7
+#define CSA 10
+#define CSB 9
+
+#define CHIPS 2
+#define TICKS 1000
+#define DIAG_EVERY 10  // Diagnostic snapshot every 10 ticks
+
+TLE75008_ESD SWA(CSA, IDLE);
+TLE75008_ESD SWB(CSB, IDLE);
+TLE75008_ESD* const chips[CHIPS] = { &SWA, &SWB };
+TLE75008_Bank bank(chips, CHIPS);
+
+uint32_t bankFrames() {
+  uint32_t frames = 0;
+  for (uint8_t i = 0; i < CHIPS; i++) frames += bank.device(i).frameCount();
+  return frames;
+}
+
+void printLine(const char* name, uint32_t ops, uint32_t actual, uint32_t minimum) {
+  Serial.print(name);
+  Serial.print(": ops=");
+  Serial.print(ops);
+  Serial.print(" frames=");
+  Serial.print(actual);
+  Serial.print(" minimum=");
+  Serial.print(minimum);
+  Serial.print(" overhead/op=");
+  Serial.println(ops ? (float)(actual - minimum) / ops : 0.0, 2);
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) {}
+  randomSeed(1);  // Same workload every run
+
+  bank.begin();
+
+  uint32_t outOps = 0, outFrames = 0, outMin = 0;
+  uint32_t diagOps = 0, diagFrames = 0, diagMin = 0;
+  byte chip[CHIPS];  // What the chips hold, to know what really changed
+  for (uint8_t i = 0; i < CHIPS; i++) chip[i] = bank.device(i).getOutputs();
+
+  for (uint16_t tick = 0; tick < TICKS; tick++) {
+    // A few random channel changes, some of them undone again before the flush
+    uint8_t changes = random(4);
+    for (uint8_t c = 0; c < changes; c++) {
+      bank.set(TLE75008_Output(random(CHIPS), random(1, 9)), random(2));
+      outOps++;
+    }
+    uint32_t before = bankFrames();
+    bank.flush();
+    outFrames += bankFrames() - before;
+    for (uint8_t i = 0; i < CHIPS; i++) {
+      if (bank.device(i).getOutputs() != chip[i]) outMin++;
+      chip[i] = bank.device(i).getOutputs();
+    }
+
+    if (tick % DIAG_EVERY == 0) {
+      before = bankFrames();
+      bank.updateDiagnostics();
+      diagFrames += bankFrames() - before;
+      for (uint8_t i = 0; i < CHIPS; i++) {
+        if (bank.device(i).loadMask()) diagMin += 3;
+      }
+      diagOps++;
+    }
+  }
+
+  printLine("outputs    ", outOps, outFrames, outMin);
+  printLine("diagnostics", diagOps, diagFrames, diagMin);
+}
+
+void loop() {
+}
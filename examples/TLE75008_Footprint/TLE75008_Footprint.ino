@@ -0,0 +1,48 @@
+/*********************************************************************************************************************
+Footprint Report For TLE75008
+
+Prints which features are compiled in (see TLE75008_Config.h) and the RAM used per chip and per bank on this board.
+*********************************************************************************************************************/
+
+#include <Arduino.h>
+#include <TLE75008_ESD.h>
+#include <TLE75008_Bank.h>
+#include <TLE75008_Logger.h>
+#include <TLE75008_Redundant.h>
+
+#define CHIPS 12  // Bank size to report
+
+void printFeature(const char* name, bool enabled) {
+  Serial.print(name);
+  Serial.println(enabled ? "on" : "off");
+}
+
+void printSize(const char* name, unsigned int size) {
+  Serial.print(name);
+  Serial.print(size);
+  Serial.println(" bytes");
+}
+
+void setup() {
+  Serial.begin(9600);
+  while (!Serial) {}
+
+  printFeature("Diagnostic cache:  ", TLE75008_ENABLE_DIAG_CACHE);
+  printFeature("Statistics:        ", TLE75008_ENABLE_STATS);
+  printFeature("Tracing:           ", TLE75008_ENABLE_TRACE);
+  printFeature("On-time guard:     ", TLE75008_ENABLE_ONTIME_GUARD);
+  printFeature("Zero-cross:        ", TLE75008_ENABLE_ZERO_CROSS);
+
+  printSize("TLE75008_ESD:      ", sizeof(TLE75008_ESD));
+  printSize("TLE75008_Bank:     ", sizeof(TLE75008_Bank) + CHIPS * (sizeof(TLE75008_ESD) + sizeof(TLE75008_ESD*)));
+#if TLE75008_ENABLE_TRACE
+  printSize("TLE75008_Trace:    ", sizeof(TLE75008_Trace));
+#endif
+#if TLE75008_ENABLE_DIAG_CACHE
+  printSize("TLE75008_Logger:   ", sizeof(TLE75008_Logger));
+  printSize("TLE75008_Redundant:", sizeof(TLE75008_Redundant));
+#endif
+}
+
+void loop() {
+}